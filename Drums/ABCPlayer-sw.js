@@ -0,0 +1,65 @@
+// Offline bundle of ABCPlayer.html: the page, the pinned abcjs build and the drum samples it plays are
+// precached when the worker is installed, so a cold start and the first note do not wait on the network.
+const CacheName = "abcplayer-v1";
+
+const PageUrl = new URL("ABCPlayer.html", self.location.href).href;
+
+// Files that never change for their URL are served from the cache only. They are the precache parameters
+// of the worker URL, registerServiceWorker of the page derives them from its abcjs script and DrumSampler.sampleUrl.
+const ImmutableUrls = new Set(new URL(self.location.href).searchParams.getAll("precache"));
+
+self.addEventListener("install", (event) => {
+  event.waitUntil(caches.open(CacheName)
+    .then(cache => cache.addAll([PageUrl, ...ImmutableUrls]))
+    .then(() => self.skipWaiting()));
+});
+
+self.addEventListener("activate", (event) => {
+  event.waitUntil(caches.keys()
+    .then(names => Promise.all(names.filter(name => name !== CacheName).map(name => caches.delete(name))))
+    .then(() => self.clients.claim()));
+});
+
+// The page comes from the cache and is refreshed in the background, so a new version shows on the next load.
+// It is opened with different query parameters, all of them share one entry.
+const fromCacheThenRefresh = async (event) => {
+  const cache = await caches.open(CacheName);
+  const cached = await cache.match(PageUrl);
+  const refresh = fetch(event.request).then(response => {
+    if (response.ok)
+      cache.put(PageUrl, response.clone());
+    return response;
+  });
+
+  if (!cached)
+    return refresh;
+
+  // offline the cached page simply stays
+  event.waitUntil(refresh.catch(() => null));
+  return cached;
+}
+
+const fromCache = async (request) => {
+  const cached = await caches.match(request.url);
+  if (cached)
+    return cached;
+
+  const response = await fetch(request);
+  if (response.ok) {
+    const cache = await caches.open(CacheName);
+    cache.put(request.url, response.clone());
+  }
+  return response;
+}
+
+// Everything else, like the ABC files given with ?uri=, goes to the network as usual
+self.addEventListener("fetch", (event) => {
+  if (event.request.method !== "GET")
+    return;
+
+  const url = new URL(event.request.url);
+  if (url.origin + url.pathname === PageUrl)
+    event.respondWith(fromCacheThenRefresh(event));
+  else if (ImmutableUrls.has(event.request.url))
+    event.respondWith(fromCache(event.request));
+});